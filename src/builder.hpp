@@ -0,0 +1,133 @@
+#ifndef SCHEDULER_BUILDER_HPP
+#define SCHEDULER_BUILDER_HPP
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+#include <boost/tuple/tuple.hpp>
+#include "dag.hpp"
+#include "scheduler.hpp"
+
+class SchedulerBuilder {
+public:
+    SchedulerBuilder& addNode(int node, const std::string& operation) {
+        operationMap[node] = operation;
+        return *this;
+    }
+
+    SchedulerBuilder& addEdge(int from, int to) {
+        edges.emplace_back(from, to);
+        return *this;
+    }
+
+    SchedulerBuilder& addLoopEdge(int from, int to, int distance) {
+        loopEdges.emplace_back(from, to, distance);
+        return *this;
+    }
+
+    SchedulerBuilder& setTiming(const std::string& operation, int latency) {
+        timingMap[operation] = latency;
+        return *this;
+    }
+
+    SchedulerBuilder& setConstraint(const std::string& operation, int units) {
+        constraintsMap[operation] = units;
+        return *this;
+    }
+
+    SchedulerBuilder& setPipelined(const std::string& operation) {
+        pipelinedResources.insert(operation);
+        return *this;
+    }
+
+    // throws std::invalid_argument when the graph or its tables could not be scheduled
+    [[nodiscard]] Scheduler build() const {
+        validate();
+
+        DAG<int> dependencyGraph;
+
+        for (const auto& [node, operation] : operationMap) {
+            dependencyGraph.addVertex(node);
+        }
+
+        for (const auto& e : edges) {
+            dependencyGraph.addEdge(e.get<0>(), e.get<1>());
+        }
+
+        return {dependencyGraph, operationMap, timingMap, constraintsMap, loopEdges, pipelinedResources};
+    }
+
+private:
+    void validate() const {
+        if (operationMap.empty()) {
+            throw std::invalid_argument("graph has no nodes");
+        }
+
+        for (const auto& [node, operation] : operationMap) {
+            auto timing = timingMap.find(operation);
+            if (timing == timingMap.end() || timing->second <= 0) {
+                throw std::invalid_argument("operation " + operation + " needs a latency of at least 1");
+            }
+            if (constraintsMap.find(operation) == constraintsMap.end()) {
+                throw std::invalid_argument("operation " + operation + " needs at least one unit");
+            }
+        }
+        Scheduler::validateConstraints(constraintsMap);
+
+        for (const auto& e : edges) {
+            requireNode(e.get<0>(), "edge");
+            requireNode(e.get<1>(), "edge");
+        }
+
+        Scheduler::validateLoopEdges(loopEdges, operationMap);
+
+        // peel off nodes without remaining parents, anything left over sits on a cycle
+        boost::unordered_map<int, int> parents;
+        for (const auto& [node, operation] : operationMap) {
+            parents[node] = 0;
+        }
+        for (const auto& e : edges) {
+            parents.at(e.get<1>())++;
+        }
+
+        std::vector<int> work;
+        for (const auto& [node, count] : parents) {
+            if (count == 0) {
+                work.push_back(node);
+            }
+        }
+
+        size_t peeled = 0;
+        while (!work.empty()) {
+            int node = work.back();
+            work.pop_back();
+            peeled++;
+            for (const auto& e : edges) {
+                if (e.get<0>() == node && --parents.at(e.get<1>()) == 0) {
+                    work.push_back(e.get<1>());
+                }
+            }
+        }
+
+        if (peeled != operationMap.size()) {
+            throw std::invalid_argument("edges close a cycle, use a loop edge to carry it across iterations");
+        }
+    }
+
+    void requireNode(int node, const std::string& what) const {
+        if (operationMap.find(node) == operationMap.end()) {
+            throw std::invalid_argument(what + " names node " + std::to_string(node) + " that was never added");
+        }
+    }
+
+    std::vector<boost::tuple<int, int>> edges;
+    boost::unordered_map<int, std::string> operationMap;
+    boost::unordered_map<std::string, int> timingMap;
+    boost::unordered_map<std::string, int> constraintsMap;
+    std::vector<boost::tuple<int, int, int>> loopEdges;
+    boost::unordered_set<std::string> pipelinedResources;
+};
+
+#endif //SCHEDULER_BUILDER_HPP
@@ -8,13 +8,18 @@ namespace po = boost::program_options;
 namespace fs = std::filesystem;
 
 int validateParams(int argc, char* argv[], po::variables_map& vm) {
-    std::string usage("Usage:\n   ./scheduler -g <graph file> -t <timing file> -c <constraints file>");
+    std::string usage("Usage:\n   ./scheduler -g <graph file> -t <timing file> -c <constraints file>"
+                      " [-m [-l <loop file>] [-p <operator>...]]");
 
     po::options_description desc("Options");
     desc.add_options()
             ("graph,g", po::value<std::string>(), "Graph file - Topological dependency for scheduling")
             ("timing,t", po::value<std::string>(),"Timing file - Latency of operators")
             ("constraints,c", po::value<std::string>(),"Constraints file - Number of operators")
+            ("modulo,m", "Modulo schedule the graph as a loop body")
+            ("loop,l", po::value<std::string>(), "Loop file - Loop-carried dependencies with iteration distance")
+            ("pipelined,p", po::value<std::vector<std::string>>()->multitoken(),
+                    "Pipelined operators - Accept a new operation every cycle")
             ("verbose,v", "Verbose output")
             ("help,h", "Prints the help menu");
 
@@ -46,6 +51,23 @@ int validateParams(int argc, char* argv[], po::variables_map& vm) {
         return 1;
     }
 
+    try {
+        Scheduler::validateConstraints(Parser::parseConstraints(constraintsFP));
+    } catch (const std::invalid_argument& e) {
+        std::cout << std::format("Provided constraints file \"{}\" is invalid: {}\n", constraintsFP, e.what());
+        return 1;
+    }
+
+    if ((vm.count("loop") || vm.count("pipelined")) && !vm.count("modulo")) {
+        std::cout << "Loop and pipelined operators only apply to modulo scheduling (-m)\n";
+        return 1;
+    }
+
+    if (vm.count("loop") && !fs::exists(vm["loop"].as<std::string>())) {
+        std::cout << std::format("Provided loop file \"{}\" does not exist\n", vm["loop"].as<std::string>());
+        return 1;
+    }
+
     return 0;
 }
 
@@ -58,9 +80,26 @@ int main(int argc, char* argv[]) {
     Scheduler scheduler(vm["graph"].as<std::string>(),
             vm["timing"].as<std::string>(),
             vm["constraints"].as<std::string>());
+
+    if (vm.count("loop")) {
+        try {
+            scheduler.loadLoopEdges(vm["loop"].as<std::string>());
+        } catch (const std::invalid_argument& e) {
+            std::cout << std::format("Provided loop file \"{}\" is invalid: {}\n", vm["loop"].as<std::string>(), e.what());
+            return 1;
+        }
+    }
+
     scheduler.makeDot();
     scheduler.exec();
 
+    if (vm.count("modulo")) {
+        if (vm.count("pipelined")) {
+            scheduler.setPipelinedResources(vm["pipelined"].as<std::vector<std::string>>());
+        }
+        scheduler.execModulo();
+    }
+
     return 0;
 }
 
@@ -72,6 +72,19 @@ public:
         return constraintsMap;
     }
 
+    static std::vector<boost::tuple<int, int, int>> parseLoopEdges(const std::string &file) {
+        std::vector<boost::tuple<int, int, int>> loopEdges;
+
+        std::ifstream stream(file);
+        int from, to, distance;
+
+        while (stream >> from >> to >> distance) {
+            loopEdges.emplace_back(from, to, distance);
+        }
+
+        return loopEdges;
+    }
+
 private:
     static int getNumNodes(const std::string &file) {
         std::ifstream stream(file);
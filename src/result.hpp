@@ -0,0 +1,78 @@
+#ifndef SCHEDULER_RESULT_HPP
+#define SCHEDULER_RESULT_HPP
+
+#include <span>
+#include <utility>
+#include <vector>
+
+// Every array is indexed alongside getNodes(), which is sorted by node
+class ScheduleResult {
+public:
+    ScheduleResult(std::vector<int> nodes, std::vector<int> asap, std::vector<int> alap, std::vector<int> slack,
+                   std::vector<int> ready, std::vector<int> running, std::vector<int> finished,
+                   int criticalPathLength, int listScheduleLength)
+            : nodes(std::move(nodes)), asap(std::move(asap)), alap(std::move(alap)), slack(std::move(slack)),
+              ready(std::move(ready)), running(std::move(running)), finished(std::move(finished)),
+              criticalPathLength(criticalPathLength), listScheduleLength(listScheduleLength) {}
+
+    [[nodiscard]] std::span<const int> getNodes() const { return nodes; }
+
+    [[nodiscard]] std::span<const int> getASAP() const { return asap; }
+
+    [[nodiscard]] std::span<const int> getALAP() const { return alap; }
+
+    [[nodiscard]] std::span<const int> getSlack() const { return slack; }
+
+    [[nodiscard]] std::span<const int> getReady() const { return ready; }
+
+    [[nodiscard]] std::span<const int> getRunning() const { return running; }
+
+    [[nodiscard]] std::span<const int> getFinished() const { return finished; }
+
+    [[nodiscard]] int getCriticalPathLength() const { return criticalPathLength; }
+
+    [[nodiscard]] int getListScheduleLength() const { return listScheduleLength; }
+
+private:
+    std::vector<int> nodes;
+    std::vector<int> asap;
+    std::vector<int> alap;
+    std::vector<int> slack;
+    std::vector<int> ready;
+    std::vector<int> running;
+    std::vector<int> finished;
+    int criticalPathLength;
+    int listScheduleLength;
+};
+
+// An II of -1 means no modulo schedule was found and getStart() is empty
+class ModuloScheduleResult {
+public:
+    ModuloScheduleResult(std::vector<int> nodes, std::vector<int> start, int ii, int resMII, int recMII, int length)
+            : nodes(std::move(nodes)), start(std::move(start)), ii(ii), resMII(resMII), recMII(recMII),
+              length(length) {}
+
+    [[nodiscard]] bool isFound() const { return ii != -1; }
+
+    [[nodiscard]] std::span<const int> getNodes() const { return nodes; }
+
+    [[nodiscard]] std::span<const int> getStart() const { return start; }
+
+    [[nodiscard]] int getII() const { return ii; }
+
+    [[nodiscard]] int getResMII() const { return resMII; }
+
+    [[nodiscard]] int getRecMII() const { return recMII; }
+
+    [[nodiscard]] int getLength() const { return length; }
+
+private:
+    std::vector<int> nodes;
+    std::vector<int> start;
+    int ii;
+    int resMII;
+    int recMII;
+    int length;
+};
+
+#endif //SCHEDULER_RESULT_HPP
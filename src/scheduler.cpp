@@ -1,5 +1,7 @@
 ﻿#include <iostream>
 #include <numeric>
+#include <limits>
+#include <stdexcept>
 #include "scheduler.hpp"
 
 Scheduler::Scheduler() = default;
@@ -10,8 +12,42 @@ Scheduler::Scheduler(const std::string &graph, const std::string &timing, const
     operationMap = Parser::buildOperationMap(graphText);
     timingMap = Parser::parseTiming(timing);
     constraintsMap = Parser::parseConstraints(constraints);
+    validateConstraints(constraintsMap);
 }
 
+void Scheduler::validateConstraints(const boost::unordered_map<std::string, int>& constraintsMap) {
+    for (const auto& [res, units] : constraintsMap) {
+        if (units <= 0) {
+            throw std::invalid_argument("operation " + res + " needs at least one unit");
+        }
+    }
+}
+
+void Scheduler::validateLoopEdges(const std::vector<boost::tuple<int, int, int>>& loopEdges,
+                                  const boost::unordered_map<int, std::string>& operationMap) {
+    for (const auto& e : loopEdges) {
+        for (int node : {e.get<0>(), e.get<1>()}) {
+            if (operationMap.find(node) == operationMap.end()) {
+                throw std::invalid_argument("loop edge names node " + std::to_string(node) + " not in the graph");
+            }
+        }
+        if (e.get<2>() <= 0) {
+            throw std::invalid_argument("loop edge " + std::to_string(e.get<0>()) + " -> " + std::to_string(e.get<1>())
+                                        + " needs an iteration distance of at least 1");
+        }
+    }
+}
+
+Scheduler::Scheduler(DAG<int> dependencyGraph,
+                     boost::unordered_map<int, std::string> operationMap,
+                     boost::unordered_map<std::string, int> timingMap,
+                     boost::unordered_map<std::string, int> constraintsMap,
+                     std::vector<boost::tuple<int, int, int>> loopEdges,
+                     boost::unordered_set<std::string> pipelinedResources)
+        : dependencyGraph(std::move(dependencyGraph)), operationMap(std::move(operationMap)),
+          timingMap(std::move(timingMap)), constraintsMap(std::move(constraintsMap)),
+          loopEdges(std::move(loopEdges)), pipelinedResources(std::move(pipelinedResources)) {}
+
 int Scheduler::getNodeTiming(int node) const {
     return timingMap.at(operationMap.at(node));
 }
@@ -64,30 +100,120 @@ void Scheduler::makeDot() {
     dependencyGraph.makeDot(std::ofstream("graph.dot"));
 }
 
+void Scheduler::loadLoopEdges(const std::string &loop) {
+    auto edges = Parser::parseLoopEdges(loop);
+    validateLoopEdges(edges, operationMap);
+    loopEdges = edges;
+}
+
+void Scheduler::setPipelinedResources(const std::vector<std::string> &resources) {
+    pipelinedResources = boost::unordered_set<std::string>(resources.begin(), resources.end());
+}
+
 void Scheduler::exec() {
-    findCriticalPath();
+    ScheduleResult result = schedule();
+
+    std::ofstream asap("asap.txt");
+    printSchedule(result.getNodes(), result.getASAP(), result.getCriticalPathLength(), asap);
+    std::ofstream alap("alap.txt");
+    printSchedule(result.getNodes(), result.getALAP(), result.getCriticalPathLength(), alap);
+    std::ofstream slack("slack.txt");
+    printSlack(result.getNodes(), result.getSlack(), slack);
+    std::ofstream list("list_scheduling.txt");
+    printListSchedule(result, list);
+}
 
+void Scheduler::execModulo() {
+    std::ofstream modulo("modulo_scheduling.txt");
+    printModuloSchedule(moduloSchedule(), modulo);
+}
 
-    boost::promise<boost::container::map<int, int>> asapSchedulePromise;
-    boost::promise<boost::container::map<int, int>> alapSchedulePromise;
-    auto asapScheduleFuture = asapSchedulePromise.get_future();
-    auto alapScheduleFuture = alapSchedulePromise.get_future();
+boost::container::map<int, int> Scheduler::findSlackSchedules(boost::container::map<int, int>& asapSchedule,
+                                                              boost::container::map<int, int>& alapSchedule) {
+    findCriticalPath();
 
-    boost::thread asapTh([this, &asapSchedulePromise] { findASAP(boost::ref(asapSchedulePromise)); });
-    boost::thread alapTh([this, &alapSchedulePromise] { findALAP(boost::ref(alapSchedulePromise)); });
-    asapTh.join();
-    alapTh.join();
+    // both passes are cheap next to starting a thread, so they run back to back
+    asapSchedule = findASAP();
+    alapSchedule = findALAP();
 
-    auto asapSchedule = asapScheduleFuture.get();
-    auto alapSchedule = alapScheduleFuture.get();
+    return findSlack(asapSchedule, alapSchedule);
+}
 
-    boost::container::map<int, int> slack = findSlack(asapSchedule, alapSchedule);
+ScheduleResult Scheduler::schedule() {
+    if (operationMap.empty()) {
+        return {{}, {}, {}, {}, {}, {}, {}, 0, 0};
+    }
+
+    boost::container::map<int, int> asapSchedule, alapSchedule;
+    boost::container::map<int, int> slack = findSlackSchedules(asapSchedule, alapSchedule);
     boost::container::map<int, boost::tuple<int, int, int>> listSchedule = findListSchedule(slack);
 
-    printSchedule(asapSchedule, std::ofstream("asap.txt"));
-    printSchedule(alapSchedule, std::ofstream("alap.txt"));
-    printSlack(slack, std::ofstream("slack.txt"));
-    printListSchedule(listSchedule, std::ofstream("list_scheduling.txt"));
+    std::vector<int> nodes, asap, alap, slackTimes, ready, running, finished;
+    for (const auto& [node, v] : listSchedule) {
+        nodes.push_back(node);
+        asap.push_back(asapSchedule.at(node));
+        alap.push_back(alapSchedule.at(node));
+        slackTimes.push_back(slack.at(node));
+        ready.push_back(v.get<READY>());
+        running.push_back(v.get<RUNNING>());
+        finished.push_back(v.get<FINISHED>());
+    }
+
+    return {std::move(nodes), std::move(asap), std::move(alap), std::move(slackTimes),
+            std::move(ready), std::move(running), std::move(finished),
+            getCriticalPathLength(), listSchedule.at(criticalPath.back()).get<FINISHED>() + 1};
+}
+
+ModuloScheduleResult Scheduler::moduloSchedule() {
+    if (operationMap.empty()) {
+        return {{}, {}, 1, 0, 0, 0};
+    }
+
+    boost::container::map<int, int> asapSchedule, alapSchedule;
+    boost::container::map<int, int> slack = findSlackSchedules(asapSchedule, alapSchedule);
+
+    int resMII = findResMII();
+    int recMII = findRecMII();
+    auto lowest = findLowestIIModuloSchedule(resMII, recMII, slack);
+
+    if (lowest.get<1>().empty()) {
+        return {{}, {}, -1, resMII, recMII, 0};
+    }
+
+    std::vector<int> nodes, start;
+    int length = 0;
+    for (auto [node, time] : lowest.get<1>()) {
+        nodes.push_back(node);
+        start.push_back(time);
+        length = std::max(length, time + getNodeTiming(node));
+    }
+
+    return {std::move(nodes), std::move(start), lowest.get<0>(), resMII, recMII, length};
+}
+
+boost::tuple<int, boost::container::map<int, int>>
+Scheduler::findLowestIIModuloSchedule(int resMII, int recMII, boost::container::map<int, int>& slack) const {
+    int maxII = std::accumulate(operationMap.begin(), operationMap.end(), std::max({resMII, recMII, 1}),
+                                [this](int a, const auto& op) {
+        return a + getNodeTiming(op.first);
+    });
+
+    boost::container::map<int, int> moduloSchedule;
+    int ii = std::max({resMII, recMII, 1});
+    for (; ii <= maxII; ii++) {
+        moduloSchedule = findIterativeModuloSchedule(ii, getModuloOrder(ii, slack, false));
+        if (moduloSchedule.empty()) {
+            moduloSchedule = findIterativeModuloSchedule(ii, getModuloOrder(ii, slack, true));
+        }
+        if (moduloSchedule.empty() && operationMap.size() <= EXHAUSTIVE_MODULO_NODES) {
+            moduloSchedule = findExhaustiveModuloSchedule(ii, slack);
+        }
+        if (!moduloSchedule.empty()) {
+            break;
+        }
+    }
+
+    return {ii, moduloSchedule};
 }
 
 bool Scheduler::areAllScheduled(const boost::unordered_set<int>& nodes,
@@ -124,7 +250,7 @@ int Scheduler::latestSchedule(int self, const boost::unordered_set<int>& childre
     return schedule.find(minNode)->second - getNodeTiming(self);
 }
 
-void Scheduler::findASAP(boost::promise<boost::container::map<int, int>>& asapSchedule) const {
+boost::container::map<int, int> Scheduler::findASAP() const {
     boost::unordered_set<int> workVertices = dependencyGraph.getVertices();
     boost::unordered_set<int> scheduled;
     boost::container::map<int, int> schedule;
@@ -156,10 +282,10 @@ void Scheduler::findASAP(boost::promise<boost::container::map<int, int>>& asapSc
         }
     }
 
-    asapSchedule.set_value(schedule);
+    return schedule;
 }
 
-void Scheduler::findALAP(boost::promise<boost::container::map<int, int>>& alapSchedule) const {
+boost::container::map<int, int> Scheduler::findALAP() const {
     boost::unordered_set<int> workVertices = dependencyGraph.getVertices();
     boost::unordered_set<int> scheduled;
     boost::container::map<int, int> schedule;
@@ -191,15 +317,16 @@ void Scheduler::findALAP(boost::promise<boost::container::map<int, int>>& alapSc
         }
     }
 
-    alapSchedule.set_value(schedule);
+    return schedule;
 }
 
-void Scheduler::printSchedule(const boost::container::map<int, int>& schedule, std::ofstream of) const {
-    for (auto [node, time] : schedule) {
-        of << "Node " << node << ": t=" << time << std::endl;
+void Scheduler::printSchedule(std::span<const int> nodes, std::span<const int> times, int finished,
+                              std::ostream& out) {
+    for (size_t i = 0; i < nodes.size(); i++) {
+        out << "Node " << nodes[i] << ": t=" << times[i] << std::endl;
     }
 
-    of << "Finished t=" << getCriticalPathLength() << std::endl;
+    out << "Finished t=" << finished << std::endl;
 }
 
 boost::container::map<int, int>
@@ -214,9 +341,9 @@ Scheduler::findSlack(boost::container::map<int, int>& asapSchedule,
     return slack;
 }
 
-void Scheduler::printSlack(boost::container::map<int, int>& slack, std::ofstream of) {
-    for (auto [node, time] : slack) {
-        of << "Node " << node << ": slack=" << time << std::endl;
+void Scheduler::printSlack(std::span<const int> nodes, std::span<const int> slack, std::ostream& out) {
+    for (size_t i = 0; i < nodes.size(); i++) {
+        out << "Node " << nodes[i] << ": slack=" << slack[i] << std::endl;
     }
 }
 
@@ -309,13 +436,482 @@ Scheduler::findListSchedule(boost::container::map<int, int>& slack) const {
     return listSchedule;
 }
 
-void Scheduler::printListSchedule(const boost::container::map<int, boost::tuple<int, int, int>>& listSchedule,
-                                  std::ofstream of) const {
-    for (const auto& [k, v] : listSchedule) {
-        of << "Node " << k << ": Ready t=" << v.get<READY>()
-                << "; Running t=" << v.get<RUNNING>() << "; Finished t=" << v.get<FINISHED>() << std::endl;
+void Scheduler::printListSchedule(const ScheduleResult& result, std::ostream& out) {
+    for (size_t i = 0; i < result.getNodes().size(); i++) {
+        out << "Node " << result.getNodes()[i] << ": Ready t=" << result.getReady()[i]
+                << "; Running t=" << result.getRunning()[i] << "; Finished t=" << result.getFinished()[i] << std::endl;
+    }
+
+    out << "Finished t=" << result.getListScheduleLength() << std::endl;
+}
+
+int Scheduler::getNodeOccupancy(int node) const {
+    if (pipelinedResources.find(operationMap.at(node)) != pipelinedResources.end()) {
+        return 1;
+    }
+
+    return getNodeTiming(node);
+}
+
+int Scheduler::findResMII() const {
+    boost::unordered_map<std::string, int> usage;
+
+    for (auto [node, res] : operationMap) {
+        usage[res] += getNodeOccupancy(node);
+    }
+
+    int resMII = 0;
+    for (auto [res, cycles] : usage) {
+        int units = constraintsMap.at(res);
+        resMII = std::max(resMII, (cycles + units - 1) / units);
+    }
+
+    return resMII;
+}
+
+std::vector<int> Scheduler::getModuloNodes() const {
+    std::vector<int> nodes;
+    for (auto [node, res] : operationMap) {
+        nodes.push_back(node);
+    }
+    std::ranges::sort(nodes);
+
+    return nodes;
+}
+
+std::vector<std::vector<int>> Scheduler::findLongestPaths(int ii) const {
+    std::vector<int> nodes = getModuloNodes();
+    boost::unordered_map<int, int> index;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        index[nodes[i]] = static_cast<int>(i);
+    }
+
+    // longest path between every pair where edge u->v weighs latency(u) - ii * distance
+    auto n = nodes.size();
+    std::vector<std::vector<int>> dist(n, std::vector<int>(n, NO_PATH));
+
+    for (const auto& e : getModuloEdges()) {
+        int from = index.at(e.get<0>());
+        int to = index.at(e.get<1>());
+        dist[from][to] = std::max(dist[from][to], getNodeTiming(e.get<0>()) - ii * e.get<2>());
+    }
+
+    for (size_t k = 0; k < n; k++) {
+        for (size_t i = 0; i < n; i++) {
+            if (dist[i][k] == NO_PATH) {
+                continue;
+            }
+            for (size_t j = 0; j < n; j++) {
+                if (dist[k][j] != NO_PATH) {
+                    dist[i][j] = std::max(dist[i][j], dist[i][k] + dist[k][j]);
+                }
+            }
+        }
+    }
+
+    return dist;
+}
+
+bool Scheduler::hasPositiveCycle(int ii) const {
+    auto dist = findLongestPaths(ii);
+
+    for (size_t i = 0; i < dist.size(); i++) {
+        if (dist[i][i] != NO_PATH && dist[i][i] > 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int Scheduler::findRecMII() const {
+    if (loopEdges.empty()) {
+        return 0;
+    }
+
+    // every cycle is carried over at least one iteration, so it is met once II covers every latency
+    int maxII = std::accumulate(operationMap.begin(), operationMap.end(), 1, [this](int a, const auto& op) {
+        return a + getNodeTiming(op.first);
+    });
+
+    int recMII = 1;
+    while (recMII < maxII && hasPositiveCycle(recMII)) {
+        recMII++;
+    }
+
+    return recMII;
+}
+
+std::vector<boost::tuple<int, int, int>> Scheduler::getModuloEdges() const {
+    std::vector<boost::tuple<int, int, int>> edges(loopEdges);
+
+    for (const auto& e : dependencyGraph.getEdges()) {
+        edges.emplace_back(e.get<0>(), e.get<1>(), 0);
+    }
+
+    return edges;
+}
+
+std::vector<int> Scheduler::getSlotUsage(const std::string& res, int ii,
+                                         const boost::container::map<int, int>& schedule) const {
+    std::vector<int> usage(ii, 0);
+
+    for (auto [node, time] : schedule) {
+        if (operationMap.at(node) == res) {
+            for (int cycle = 0; cycle < getNodeOccupancy(node); cycle++) {
+                usage[(time + cycle) % ii]++;
+            }
+        }
+    }
+
+    return usage;
+}
+
+std::vector<int> Scheduler::getModuloOrder(int ii, boost::container::map<int, int>& slack,
+                                           bool recurrencesFirst) const {
+    std::vector<int> nodes = getModuloNodes();
+    auto dist = findLongestPaths(ii);
+
+    // height of each node above the end of the iteration, with loop-carried edges shortened by ii
+    std::vector<int> height(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++) {
+        height[i] = getNodeTiming(nodes[i]);
+        for (size_t j = 0; j < nodes.size(); j++) {
+            if (dist[i][j] != NO_PATH) {
+                height[i] = std::max(height[i], dist[i][j] + getNodeTiming(nodes[j]));
+            }
+        }
+    }
+
+    // recurrences have the least freedom at a tight II, so their members may go first
+    std::vector<size_t> order(nodes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::sort(order, [&](size_t a, size_t b) {
+        return boost::make_tuple(recurrencesFirst && dist[a][a] == NO_PATH, -height[a], slack.at(nodes[a]), nodes[a])
+               < boost::make_tuple(recurrencesFirst && dist[b][b] == NO_PATH, -height[b], slack.at(nodes[b]), nodes[b]);
+    });
+
+    std::vector<int> ordered;
+    for (auto i : order) {
+        ordered.push_back(nodes[i]);
+    }
+
+    return ordered;
+}
+
+boost::container::map<int, int>
+Scheduler::findIterativeModuloSchedule(int ii, const std::vector<int>& order) const {
+    auto edges = getModuloEdges();
+
+    boost::container::map<int, int> schedule;
+    boost::unordered_map<int, int> lastTime;
+    int budget = MODULO_BUDGET_RATIO * static_cast<int>(operationMap.size());
+
+    while (schedule.size() < operationMap.size() && budget-- > 0) {
+        int node = *std::ranges::find_if(order, [&schedule](int n) { return schedule.find(n) == schedule.end(); });
+        const std::string& res = operationMap.at(node);
+        int units = constraintsMap.at(res);
+
+        int earliest = 0;
+        for (const auto& e : edges) {
+            if (e.get<1>() == node && e.get<0>() != node && schedule.find(e.get<0>()) != schedule.end()) {
+                earliest = std::max(earliest, schedule.at(e.get<0>()) + getNodeTiming(e.get<0>()) - ii * e.get<2>());
+            }
+        }
+
+        auto fits = [&](int time) {
+            std::vector<int> usage = getSlotUsage(res, ii, schedule);
+            for (int cycle = 0; cycle < getNodeOccupancy(node); cycle++) {
+                usage[(time + cycle) % ii]++;
+            }
+            return std::ranges::all_of(usage, [units](int used) { return used <= units; });
+        };
+
+        int time = earliest;
+        while (time < earliest + ii && !fits(time)) {
+            time++;
+        }
+        if (time == earliest + ii) {
+            // no free slot, so force the node in and evict whatever it collides with
+            time = lastTime.find(node) != lastTime.end() && lastTime.at(node) >= earliest
+                   ? lastTime.at(node) + 1 : earliest;
+        }
+
+        while (!fits(time)) {
+            std::vector<int> usage = getSlotUsage(res, ii, schedule);
+            std::vector<bool> overused(ii, false);
+            for (int cycle = 0; cycle < getNodeOccupancy(node); cycle++) {
+                overused[(time + cycle) % ii] = ++usage[(time + cycle) % ii] > units;
+            }
+
+            auto victim = std::ranges::find_if(schedule, [&](const auto& scheduled) {
+                if (operationMap.at(scheduled.first) != res) {
+                    return false;
+                }
+                for (int cycle = 0; cycle < getNodeOccupancy(scheduled.first); cycle++) {
+                    if (overused[(scheduled.second + cycle) % ii]) {
+                        return true;
+                    }
+                }
+                return false;
+            });
+            if (victim == schedule.end()) {
+                return {};
+            }
+            schedule.erase(victim);
+        }
+
+        for (const auto& e : edges) {
+            int to = e.get<1>();
+            if (e.get<0>() == node && to != node && schedule.find(to) != schedule.end()
+                    && schedule.at(to) < time + getNodeTiming(node) - ii * e.get<2>()) {
+                schedule.erase(to);
+            }
+        }
+
+        schedule[node] = time;
+        lastTime[node] = time;
+    }
+
+    if (schedule.size() < operationMap.size()) {
+        return {};
+    }
+
+    // evictions only ever push nodes later, so pull every node back to its earliest stage
+    for (auto& [node, time] : schedule) {
+        time %= ii;
+    }
+
+    return findModuloStages(ii, schedule);
+}
+
+boost::container::map<int, int>
+Scheduler::findModuloStages(int ii, const boost::container::map<int, int>& slots) const {
+    // with every node pinned to a slot, each edge bounds the stage difference of its endpoints
+    std::vector<boost::tuple<int, int, int>> bounds;
+    for (const auto& e : getModuloEdges()) {
+        int from = e.get<0>();
+        int to = e.get<1>();
+        if (slots.find(from) == slots.end() || slots.find(to) == slots.end()) {
+            continue;
+        }
+
+        int gap = slots.at(from) + getNodeTiming(from) - ii * e.get<2>() - slots.at(to);
+        int stages = gap > 0 ? (gap + ii - 1) / ii : -(-gap / ii);
+        bounds.emplace_back(from, to, stages);
+    }
+
+    boost::container::map<int, int> stage;
+    for (auto [node, slot] : slots) {
+        stage[node] = 0;
+    }
+
+    for (size_t pass = 0; pass <= slots.size(); pass++) {
+        bool changed = false;
+        for (const auto& b : bounds) {
+            if (stage.at(b.get<1>()) < stage.at(b.get<0>()) + b.get<2>()) {
+                stage.at(b.get<1>()) = stage.at(b.get<0>()) + b.get<2>();
+                changed = true;
+            }
+        }
+        if (!changed) {
+            boost::container::map<int, int> schedule;
+            for (auto [node, slot] : slots) {
+                schedule[node] = slot + ii * stage.at(node);
+            }
+            return schedule;
+        }
+    }
+
+    return {};
+}
+
+boost::container::map<int, int>
+Scheduler::findExhaustiveModuloSchedule(int ii, boost::container::map<int, int>& slack) const {
+    std::vector<int> nodes = getModuloNodes();
+    auto dist = findLongestPaths(ii);
+    auto n = nodes.size();
+
+    boost::unordered_map<int, size_t> index;
+    for (size_t i = 0; i < n; i++) {
+        index[nodes[i]] = i;
+    }
+    std::vector<size_t> order;
+    for (int node : getModuloOrder(ii, slack, true)) {
+        order.push_back(index.at(node));
+    }
+
+    boost::unordered_map<std::string, std::vector<int>> usage;
+    for (auto [res, num] : constraintsMap) {
+        usage[res] = std::vector<int>(ii, 0);
+    }
+
+    // only slots are fixed while searching, stages follow from the longest chain of stage bounds
+    // between placed nodes, so every slot of a node is tried exactly once and the search is exact
+    std::vector<int> slot(n, -1);
+    std::vector<size_t> placed;
+    std::vector<std::vector<int>> stages(n, std::vector<int>(n, NO_PATH));
+
+    auto stageBound = [&](size_t from, size_t to) {
+        if (dist[from][to] == NO_PATH) {
+            return NO_PATH;
+        }
+        int gap = slot[from] + dist[from][to] - slot[to];
+        return gap > 0 ? (gap + ii - 1) / ii : -(-gap / ii);
+    };
+
+    auto earliestStage = [&](size_t node) {
+        int stage = 0;
+        for (auto other : placed) {
+            stage = std::max(stage, stages[other][node]);
+        }
+        return stage;
+    };
+
+    auto occupy = [&](size_t node, int time, int delta) {
+        std::vector<int>& slots = usage.at(operationMap.at(nodes[node]));
+        bool fits = true;
+        for (int cycle = 0; cycle < getNodeOccupancy(nodes[node]); cycle++) {
+            slots[(time + cycle) % ii] += delta;
+            fits &= slots[(time + cycle) % ii] <= constraintsMap.at(operationMap.at(nodes[node]));
+        }
+        return fits;
+    };
+
+    boost::unordered_map<std::string, int> unplaced;
+    for (auto [node, res] : operationMap) {
+        unplaced[res]++;
+    }
+
+    // a single unit is cut into free runs by its placed operations, and every run only fits so many more
+    auto leavesRoom = [&](const std::string& res) {
+        const std::vector<int>& slots = usage.at(res);
+        int occupancy = pipelinedResources.find(res) != pipelinedResources.end() ? 1 : timingMap.at(res);
+        if (constraintsMap.at(res) > 1 || occupancy == 1) {
+            return true;
+        }
+
+        auto used = std::ranges::find_if(slots, [](int u) { return u > 0; });
+        if (used == slots.end()) {
+            return ii / occupancy >= unplaced.at(res);
+        }
+
+        int room = 0, run = 0;
+        auto first = used - slots.begin();
+        for (int i = 1; i <= ii; i++) {
+            if (slots[(first + i) % ii] == 0) {
+                run++;
+            } else {
+                room += run / occupancy;
+                run = 0;
+            }
+        }
+
+        return room >= unplaced.at(res);
+    };
+
+    auto search = [&](auto& self, size_t depth) -> bool {
+        if (depth == n) {
+            return true;
+        }
+
+        size_t node = order[depth];
+        int earliest = 0;
+        for (auto other : placed) {
+            if (dist[other][node] != NO_PATH) {
+                earliest = std::max(earliest, slot[other] + ii * earliestStage(other) + dist[other][node]);
+            }
+        }
+
+        // shifting a whole schedule keeps it valid, so the first node only needs one slot
+        int window = depth == 0 ? 1 : ii;
+        for (int time = earliest; time < earliest + window; time++) {
+            const std::string& res = operationMap.at(nodes[node]);
+            unplaced.at(res)--;
+            if (!occupy(node, time, 1) || !leavesRoom(res)) {
+                occupy(node, time, -1);
+                unplaced.at(res)++;
+                continue;
+            }
+            slot[node] = time % ii;
+
+            // longest stage chains into and out of the new node through the placed ones
+            std::vector<int> in(n, NO_PATH), out(n, NO_PATH);
+            for (auto u : placed) {
+                in[u] = stageBound(u, node);
+                out[u] = stageBound(node, u);
+            }
+            for (auto u : placed) {
+                for (auto x : placed) {
+                    if (stages[u][x] != NO_PATH && stageBound(x, node) != NO_PATH) {
+                        in[u] = std::max(in[u], stages[u][x] + stageBound(x, node));
+                    }
+                    if (stages[x][u] != NO_PATH && stageBound(node, x) != NO_PATH) {
+                        out[u] = std::max(out[u], stageBound(node, x) + stages[x][u]);
+                    }
+                }
+            }
+
+            bool feasible = stageBound(node, node) == NO_PATH || stageBound(node, node) <= 0;
+            for (auto u : placed) {
+                feasible &= in[u] == NO_PATH || out[u] == NO_PATH || in[u] + out[u] <= 0;
+            }
+
+            if (feasible) {
+                auto saved = stages;
+                for (auto u : placed) {
+                    stages[u][node] = in[u];
+                    stages[node][u] = out[u];
+                    for (auto w : placed) {
+                        if (in[u] != NO_PATH && out[w] != NO_PATH) {
+                            stages[u][w] = std::max(stages[u][w], in[u] + out[w]);
+                        }
+                    }
+                }
+                placed.push_back(node);
+
+                if (self(self, depth + 1)) {
+                    return true;
+                }
+
+                placed.pop_back();
+                stages = saved;
+            }
+
+            slot[node] = -1;
+            occupy(node, time, -1);
+            unplaced.at(res)++;
+        }
+
+        return false;
+    };
+
+    if (!search(search, 0)) {
+        return {};
+    }
+
+    boost::container::map<int, int> schedule;
+    for (size_t i = 0; i < n; i++) {
+        schedule[nodes[i]] = slot[i] + ii * earliestStage(i);
+    }
+
+    return schedule;
+}
+
+void Scheduler::printModuloSchedule(const ModuloScheduleResult& result, std::ostream& out) {
+    out << "ResMII=" << result.getResMII() << "; RecMII=" << result.getRecMII() << std::endl;
+
+    if (!result.isFound()) {
+        out << "No modulo schedule found" << std::endl;
+        return;
+    }
+
+    int ii = result.getII();
+    for (size_t i = 0; i < result.getNodes().size(); i++) {
+        int time = result.getStart()[i];
+        out << "Node " << result.getNodes()[i] << ": t=" << time << "; Stage=" << time / ii
+                << "; Slot=" << time % ii << std::endl;
     }
 
-    int runtime = listSchedule.at(criticalPath.back()).get<FINISHED>() + 1;
-    of << "Finished t=" <<  runtime << std::endl;
+    out << "II=" << ii << "; Finished t=" << result.getLength() << std::endl;
 }
\ No newline at end of file
@@ -1,24 +1,45 @@
 #ifndef SCHEDULER_SCHEDULER_HPP
 #define SCHEDULER_SCHEDULER_HPP
-#define BOOST_THREAD_PROVIDES_FUTURE
 #include <fstream>
+#include <limits>
 #include <boost/algorithm/string.hpp>
 #include <boost/unordered_map.hpp>
 #include <boost/container/map.hpp>
 #include <boost/container/set.hpp>
-#include <boost/thread.hpp>
-#include <boost/thread/future.hpp>
 #include "dag.hpp"
 #include "parser.hpp"
+#include "result.hpp"
 
 class Scheduler {
 public:
     Scheduler();
     Scheduler(const std::string& graph, const std::string& timing, const std::string& constraints);
     void exec();
+    void execModulo();
+    ScheduleResult schedule();
+    ModuloScheduleResult moduloSchedule();
     void makeDot();
+    void loadLoopEdges(const std::string& loop);
+    void setPipelinedResources(const std::vector<std::string>& resources);
+    static void validateConstraints(const boost::unordered_map<std::string, int>& constraintsMap);
+    static void validateLoopEdges(const std::vector<boost::tuple<int, int, int>>& loopEdges,
+                                  const boost::unordered_map<int, std::string>& operationMap);
+    static void printSchedule(std::span<const int> nodes, std::span<const int> times, int finished, std::ostream& out);
+    static void printSlack(std::span<const int> nodes, std::span<const int> slack, std::ostream& out);
+    static void printListSchedule(const ScheduleResult& result, std::ostream& out);
+    static void printModuloSchedule(const ModuloScheduleResult& result, std::ostream& out);
 
 private:
+    // only SchedulerBuilder, which validates its tables first, builds a Scheduler from memory
+    friend class SchedulerBuilder;
+
+    Scheduler(DAG<int> dependencyGraph,
+              boost::unordered_map<int, std::string> operationMap,
+              boost::unordered_map<std::string, int> timingMap,
+              boost::unordered_map<std::string, int> constraintsMap,
+              std::vector<boost::tuple<int, int, int>> loopEdges,
+              boost::unordered_set<std::string> pipelinedResources);
+
     static bool areAllScheduled(const boost::unordered_set<int>& nodes, boost::container::map<int, int> &schedule);
 
     static bool areAllScheduled(const boost::unordered_set<int> &nodes,
@@ -27,9 +48,8 @@ private:
     static boost::container::map<int, int>
     findSlack(boost::container::map<int, int>& asapSchedule, boost::container::map<int, int>& alapSchedule);
 
-    static void printSlack(boost::container::map<int, int>& slack, std::basic_ofstream<char> of);
-
-    void printSchedule(const boost::container::map<int, int>& schedule, std::ofstream) const;
+    boost::container::map<int, int> findSlackSchedules(boost::container::map<int, int>& asapSchedule,
+                                                       boost::container::map<int, int>& alapSchedule);
 
     [[nodiscard]] int getCriticalPathLength() const;
 
@@ -41,22 +61,55 @@ private:
 
     [[nodiscard]] boost::tuple<int, std::vector<int>> findCriticalPathHelper(const boost::tuple<int, std::vector<int>>& path) const;
 
-    void findASAP(boost::promise<boost::container::map<int, int>>& asapSchedule)const ;
+    [[nodiscard]] boost::container::map<int, int> findASAP() const;
 
-    void findALAP(boost::promise<boost::container::map<int, int>>& alapSchedule)const ;
+    [[nodiscard]] boost::container::map<int, int> findALAP() const;
 
     boost::container::map<int, boost::tuple<int, int, int>>
     findListSchedule(boost::container::map<int, int>& slack) const;
 
-    void
-    printListSchedule(const boost::container::map<int, boost::tuple<int, int, int>> &listSchedule, std::ofstream of) const;
-
     boost::unordered_map<std::string, boost::unordered_set<int>>
     hasResourceAndNode(const boost::unordered_map<std::string, int>& resources,
                        boost::container::map<int, boost::tuple<int, int, int>>& listSchedule) const;
 
     void findCriticalPath();
 
+    [[nodiscard]] int getNodeOccupancy(int node) const;
+
+    [[nodiscard]] int findResMII() const;
+
+    [[nodiscard]] std::vector<int> getModuloNodes() const;
+
+    [[nodiscard]] std::vector<std::vector<int>> findLongestPaths(int ii) const;
+
+    [[nodiscard]] bool hasPositiveCycle(int ii) const;
+
+    [[nodiscard]] int findRecMII() const;
+
+    [[nodiscard]] std::vector<boost::tuple<int, int, int>> getModuloEdges() const;
+
+    [[nodiscard]] std::vector<int> getSlotUsage(const std::string& res, int ii,
+                                                const boost::container::map<int, int>& schedule) const;
+
+    std::vector<int> getModuloOrder(int ii, boost::container::map<int, int>& slack, bool recurrencesFirst) const;
+
+    [[nodiscard]] boost::container::map<int, int>
+    findIterativeModuloSchedule(int ii, const std::vector<int>& order) const;
+
+    [[nodiscard]] boost::container::map<int, int>
+    findModuloStages(int ii, const boost::container::map<int, int>& slots) const;
+
+    boost::container::map<int, int>
+    findExhaustiveModuloSchedule(int ii, boost::container::map<int, int>& slack) const;
+
+    boost::tuple<int, boost::container::map<int, int>>
+    findLowestIIModuloSchedule(int resMII, int recMII, boost::container::map<int, int>& slack) const;
+
+    // iterative modulo scheduling may place each node this many times before giving up on an II
+    static constexpr int MODULO_BUDGET_RATIO = 6;
+    // loop bodies up to this size fall back to an exact search when the iterative scheduler fails
+    static constexpr size_t EXHAUSTIVE_MODULO_NODES = 12;
+    static constexpr int NO_PATH = std::numeric_limits<int>::min();
     static constexpr int READY = 0;
     static constexpr int RUNNING = 1;
     static constexpr int FINISHED = 2;
@@ -65,6 +118,10 @@ private:
     boost::unordered_map<int, std::string> operationMap;
     boost::unordered_map<std::string, int> timingMap;
     boost::unordered_map<std::string, int> constraintsMap;
+    // (from, to, iteration distance) of edges carried across loop iterations
+    std::vector<boost::tuple<int, int, int>> loopEdges;
+    // resources that accept a new operation every cycle regardless of latency
+    boost::unordered_set<std::string> pipelinedResources;
 };
 
 #endif //SCHEDULER_SCHEDULER_HPP
@@ -0,0 +1,124 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "builder.hpp"
+
+// test/graph.txt, test/timing.txt and test/constraints.txt built through the library
+static SchedulerBuilder graphBuilder() {
+    return SchedulerBuilder()
+            .addNode(0, "ADD").addNode(1, "MULT").addNode(2, "ADD").addNode(3, "MULT")
+            .addNode(4, "ADD").addNode(5, "ADD").addNode(6, "MULT").addNode(7, "MULT")
+            .addEdge(0, 3).addEdge(0, 4).addEdge(0, 7).addEdge(1, 3)
+            .addEdge(2, 6).addEdge(3, 5).addEdge(4, 5)
+            .setTiming("ADD", 1).setTiming("MULT", 3)
+            .setConstraint("ADD", 1).setConstraint("MULT", 2);
+}
+
+// test/loop.txt
+static SchedulerBuilder loopBuilder() {
+    return graphBuilder().addLoopEdge(5, 0, 1).addLoopEdge(3, 1, 2);
+}
+
+static std::string readExpected(const std::string& name) {
+    std::ifstream stream(std::string(TEST_DIR) + "/" + name);
+    std::stringstream ss;
+    ss << stream.rdbuf();
+    return ss.str();
+}
+
+static bool check(const std::string& name, const std::string& actual) {
+    std::string expected = readExpected(name);
+    if (actual == expected) {
+        return true;
+    }
+
+    std::cout << name << " mismatch\nexpected:\n" << expected << "actual:\n" << actual;
+    return false;
+}
+
+static bool throwsOnBuild(const SchedulerBuilder& builder) {
+    try {
+        static_cast<void>(builder.build());
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+
+    return false;
+}
+
+// the snippet from README.md
+static bool readmeExample() {
+    Scheduler scheduler = SchedulerBuilder()
+            .addNode(0, "ADD").addNode(1, "MULT").addEdge(0, 1)
+            .setTiming("ADD", 1).setTiming("MULT", 3)
+            .setConstraint("ADD", 1).setConstraint("MULT", 2)
+            .build();
+
+    ScheduleResult result = scheduler.schedule();
+    ModuloScheduleResult modulo = scheduler.moduloSchedule();
+
+    return result.getASAP()[1] == 1 && modulo.isFound() && modulo.getII() == 2;
+}
+
+// a recurrence that only closes at II=9 while A needs eight cycles of its two units
+static bool recurrenceExample() {
+    SchedulerBuilder builder;
+    std::string operations = "CAACBBAACA";
+    for (int node = 0; node < 10; node++) {
+        builder.addNode(node, operations.substr(node, 1));
+    }
+
+    ModuloScheduleResult modulo = builder
+            .addEdge(0, 4).addEdge(0, 9).addEdge(1, 8).addEdge(2, 3).addEdge(2, 9).addEdge(3, 4)
+            .addEdge(3, 6).addEdge(4, 7).addEdge(4, 9).addEdge(6, 7).addEdge(7, 9)
+            .addLoopEdge(9, 6, 1)
+            .setTiming("A", 3).setTiming("B", 1).setTiming("C", 2)
+            .setConstraint("A", 2).setConstraint("B", 1).setConstraint("C", 1)
+            .build().moduloSchedule();
+
+    return modulo.isFound() && modulo.getII() == 9 && modulo.getResMII() == 8 && modulo.getRecMII() == 9;
+}
+
+int main() {
+    bool passed = true;
+
+    ScheduleResult result = graphBuilder().build().schedule();
+    std::stringstream asap, alap, slack, list;
+    Scheduler::printSchedule(result.getNodes(), result.getASAP(), result.getCriticalPathLength(), asap);
+    Scheduler::printSchedule(result.getNodes(), result.getALAP(), result.getCriticalPathLength(), alap);
+    Scheduler::printSlack(result.getNodes(), result.getSlack(), slack);
+    Scheduler::printListSchedule(result, list);
+    passed &= check("asap_expected.txt", asap.str());
+    passed &= check("alap_expected.txt", alap.str());
+    passed &= check("slack_expected.txt", slack.str());
+    passed &= check("list_scheduling_expected.txt", list.str());
+
+    std::stringstream modulo, pipelined;
+    Scheduler::printModuloSchedule(loopBuilder().build().moduloSchedule(), modulo);
+    Scheduler::printModuloSchedule(loopBuilder().setPipelined("MULT").build().moduloSchedule(), pipelined);
+    passed &= check("modulo_scheduling_expected.txt", modulo.str());
+    passed &= check("modulo_scheduling_pipelined_expected.txt", pipelined.str());
+
+    if (!readmeExample()) {
+        std::cout << "README example mismatch" << std::endl;
+        passed = false;
+    }
+
+    if (!recurrenceExample()) {
+        std::cout << "recurrence example mismatch" << std::endl;
+        passed = false;
+    }
+
+    if (!throwsOnBuild(SchedulerBuilder())
+            || !throwsOnBuild(graphBuilder().addEdge(0, 8))
+            || !throwsOnBuild(graphBuilder().addLoopEdge(5, 0, 0))
+            || !throwsOnBuild(graphBuilder().addNode(8, "DIV"))
+            || !throwsOnBuild(graphBuilder().addEdge(5, 0))) {
+        std::cout << "invalid builder input was accepted" << std::endl;
+        passed = false;
+    }
+
+    return passed ? 0 : 1;
+}